@@ -147,8 +147,8 @@ inline float dot(const vec3& lh, const vec3& rh) {
 // Calculates the cross produce for a given vec3
 // Original Code: Peter Shirley (2020) "Ray Tracing in One Weekend"
 // Modified by: Michael Kashian
-inline vec3 cross(const vec3& rh, const vec3& lh) {
-	return vec3(lh.y * rh.z - rh.z * lh.y,
+inline vec3 cross(const vec3& lh, const vec3& rh) {
+	return vec3(lh.y * rh.z - lh.z * rh.y,
 		lh.z * rh.x - lh.x * rh.z,
 		lh.x * rh.y - lh.y * rh.x);
 }
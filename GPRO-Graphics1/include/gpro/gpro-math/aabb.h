@@ -0,0 +1,67 @@
+/*
+    aabb.h
+    Class creation for aabb class; Axis-aligned bounding box used to skip objects a ray cannot hit
+
+    Original code: Peter Shirley (2020) "Ray Tracing: The Next Week" (Version 3.2.0) [Source Code]. https://raytracing.github.io/books/RayTracingTheNextWeek.html#boundingvolumehierarchies
+    Modified by: Michael Kashian (2020)
+*/
+
+#ifndef AABB_H
+#define AABB_H
+
+#include "gpro/gpro-math/ray.h"
+
+// Original Code: Peter Shirley (2020) "Ray Tracing: The Next Week"
+// Modified by: Michael Kashian
+class aabb {
+public:
+    aabb() {}   // Default constructor
+    aabb(const vec3& a, const vec3& b) : minimum(a), maximum(b) {} // Constructor with the min and max corners
+
+    vec3 min() const { return minimum; }    // Returns minimum
+    vec3 max() const { return maximum; }    // Returns maximum
+
+    // Determines if the ray passes through the box between t_min and t_max (slab test)
+    // Uses the query's precomputed inverse direction instead of dividing per axis
+    // Original Code: Peter Shirley (2020) "Ray Tracing: The Next Week"
+    // Modified by: Michael Kashian
+    bool hit(const ray_query& q, float t_min, float t_max) const {
+        for (int a = 0; a < 3; a++) {
+            float invD = q.inv_dir.v[a];
+            float t0 = (minimum.v[a] - q.r.orig.v[a]) * invD;
+            float t1 = (maximum.v[a] - q.r.orig.v[a]) * invD;
+            if (invD < 0.0f) {
+                float temp = t0;
+                t0 = t1;
+                t1 = temp;
+            }
+            t_min = t0 > t_min ? t0 : t_min;
+            t_max = t1 < t_max ? t1 : t_max;
+            if (t_max <= t_min) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+public:
+    vec3 minimum;
+    vec3 maximum;
+};
+
+// Returns the smallest box containing both boxes
+// Original Code: Peter Shirley (2020) "Ray Tracing: The Next Week"
+// Modified by: Michael Kashian
+inline aabb surrounding_box(const aabb& box0, const aabb& box1) {
+    vec3 box_min(fminf(box0.minimum.x, box1.minimum.x),
+        fminf(box0.minimum.y, box1.minimum.y),
+        fminf(box0.minimum.z, box1.minimum.z));
+
+    vec3 box_max(fmaxf(box0.maximum.x, box1.maximum.x),
+        fmaxf(box0.maximum.y, box1.maximum.y),
+        fmaxf(box0.maximum.z, box1.maximum.z));
+
+    return aabb(box_min, box_max);
+}
+
+#endif
\ No newline at end of file
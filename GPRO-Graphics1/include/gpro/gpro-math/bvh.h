@@ -0,0 +1,130 @@
+/*
+    bvh.h
+    Class creation for bvh_node class; Bounding volume hierarchy so a ray only tests the objects whose boxes it passes through
+
+    Original code: Peter Shirley (2020) "Ray Tracing: The Next Week" (Version 3.2.0) [Source Code]. https://raytracing.github.io/books/RayTracingTheNextWeek.html#boundingvolumehierarchies
+    Modified by: Michael Kashian (2020)
+*/
+
+#ifndef BVH_H
+#define BVH_H
+
+#include "gpro/gpro-math/hittable.h"
+#include "gpro/gpro-math/hittable_list.h"
+#include <algorithm>
+#include <iostream>
+
+// Original Code: Peter Shirley (2020) "Ray Tracing: The Next Week"
+// Modified by: Michael Kashian
+class bvh_node : public hittable {
+public:
+    bvh_node() {}   // Default constructor
+    bvh_node(hittable_list list, float time0, float time1)
+        : bvh_node(list.objects, 0, list.objects.size(), time0, time1) {}   // Constructor with a list (copied, so its objects can be sorted); boxes cover the shutter interval [time0, time1]
+    bvh_node(std::vector<shared_ptr<hittable>>& objects, size_t start, size_t end, float time0, float time1);  // Constructor with a span of objects, which is sorted in place
+
+    virtual bool hit_t(const ray_query& q, float tmin, float tmax, float& t, const hittable*& object) const override;   // Closest t where the ray hits either child
+    virtual bool bounding_box(float time0, float time1, aabb& output_box) const override;     // Box enclosing both children
+    virtual void cull(const frustum& f, float time0, float time1, std::vector<const hittable*>& candidates) const override;   // Culls the whole subtree at once where it can
+
+public:
+    shared_ptr<hittable> left;
+    shared_ptr<hittable> right;
+    aabb box;
+};
+
+// Compares two objects by the minimum of their boxes along one axis
+// Original Code: Peter Shirley (2020) "Ray Tracing: The Next Week"
+// Modified by: Michael Kashian
+inline bool box_compare(const shared_ptr<hittable>& a, const shared_ptr<hittable>& b, int axis, float time0, float time1) {
+    aabb box_a;
+    aabb box_b;
+
+    if (!a->bounding_box(time0, time1, box_a) || !b->bounding_box(time0, time1, box_b)) {
+        std::cerr << "No bounding box in bvh_node constructor.\n";
+    }
+    return box_a.min().v[axis] < box_b.min().v[axis];
+}
+
+// Constructor implementation
+// Splits along the longest axis of the span's bounds rather than a random one so the tree is the same every run
+// Original Code: Peter Shirley (2020) "Ray Tracing: The Next Week"
+// Modified by: Michael Kashian
+bvh_node::bvh_node(std::vector<shared_ptr<hittable>>& objects, size_t start, size_t end, float time0, float time1) {
+    aabb span_box;
+    objects[start]->bounding_box(time0, time1, span_box);
+    for (size_t i = start + 1; i < end; i++) {
+        aabb temp_box;
+        objects[i]->bounding_box(time0, time1, temp_box);
+        span_box = surrounding_box(span_box, temp_box);
+    }
+    vec3 extent = span_box.max() - span_box.min();
+    int axis = (extent.x > extent.y && extent.x > extent.z) ? 0 : (extent.y > extent.z ? 1 : 2);
+
+    size_t object_span = end - start;
+    if (object_span == 1) {
+        left = right = objects[start];
+    }
+    else if (object_span == 2) {
+        if (box_compare(objects[start], objects[start + 1], axis, time0, time1)) {
+            left = objects[start];
+            right = objects[start + 1];
+        }
+        else {
+            left = objects[start + 1];
+            right = objects[start];
+        }
+    }
+    else {
+        std::sort(objects.begin() + start, objects.begin() + end,
+            [axis, time0, time1](const shared_ptr<hittable>& a, const shared_ptr<hittable>& b) {
+                return box_compare(a, b, axis, time0, time1);
+            });
+
+        size_t mid = start + object_span / 2;
+        left = make_shared<bvh_node>(objects, start, mid, time0, time1);
+        right = make_shared<bvh_node>(objects, mid, end, time0, time1);
+    }
+
+    aabb box_left, box_right;
+    if (!left->bounding_box(time0, time1, box_left) || !right->bounding_box(time0, time1, box_right)) {
+        std::cerr << "No bounding box in bvh_node constructor.\n";
+    }
+    box = surrounding_box(box_left, box_right);
+}
+
+// hit_t function implementation
+// Original Code: Peter Shirley (2020) "Ray Tracing: The Next Week"
+// Modified by: Michael Kashian
+bool bvh_node::hit_t(const ray_query& q, float t_min, float t_max, float& t, const hittable*& object) const {
+    if (!box.hit(q, t_min, t_max)) {
+        return false;
+    }
+
+    // The right child only needs to beat whatever the left child already hit
+    bool hit_left = left->hit_t(q, t_min, t_max, t, object);
+    bool hit_right = right->hit_t(q, t_min, hit_left ? t : t_max, t, object);
+
+    return hit_left || hit_right;
+}
+
+// bounding_box function implementation
+// Original Code: Peter Shirley (2020) "Ray Tracing: The Next Week"
+// Modified by: Michael Kashian
+bool bvh_node::bounding_box(float time0, float time1, aabb& output_box) const {
+    output_box = box;
+    return true;
+}
+
+// cull function implementation
+// A node outside the frustum drops its whole subtree with one test; otherwise both children are culled in turn
+void bvh_node::cull(const frustum& f, float time0, float time1, std::vector<const hittable*>& candidates) const {
+    if (!f.overlaps(box)) {
+        return;
+    }
+    left->cull(f, time0, time1, candidates);
+    if (right != left) {
+        right->cull(f, time0, time1, candidates);
+    }
+}
+#endif
\ No newline at end of file
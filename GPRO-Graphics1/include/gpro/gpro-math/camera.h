@@ -0,0 +1,57 @@
+/*
+    camera.h
+    Class creation for camera class; Holds the viewport basis and shutter interval and generates rays through it
+
+    Original code: Peter Shirley (2020) "Ray Tracing in One Weekend" (Version 3.2.0) [Source Code]. https://raytracing.github.io/books/RayTracingInOneWeekend.html#antialiasing/somerandomnumberutilities
+    Modified by: Michael Kashian (2020)
+*/
+
+#ifndef CAMERA_H
+#define CAMERA_H
+
+#include "gpro/gpro-math/rtweekend.h"
+#include "gpro/gpro-math/frustum.h"
+
+// Original Code: Peter Shirley (2020) "Ray Tracing in One Weekend"
+// Modified by: Michael Kashian
+class camera {
+public:
+    // Constructor with the image shape and the shutter interval; the camera sits at the origin looking down -z
+    camera(float aspect_ratio, float viewport_height, float focal_length, float _time0 = 0.0f, float _time1 = 0.0f) {
+        float viewport_width = aspect_ratio * viewport_height;
+
+        origin = vec3(0.0f, 0.0f, 0.0f);
+        horizontal = vec3(viewport_width, 0.0f, 0.0f);
+        vertical = vec3(0.0f, viewport_height, 0.0f);
+        lower_left_corner = origin - horizontal / 2 - vertical / 2 - vec3(0.0f, 0.0f, focal_length);
+        time0 = _time0;
+        time1 = _time1;
+    }
+
+    // Returns the ray through viewport coordinates (u, v) at a random time in the shutter interval
+    // Original Code: Peter Shirley (2020) "Ray Tracing in One Weekend"
+    // Modified by: Michael Kashian
+    ray get_ray(float u, float v) const {
+        return ray(origin, lower_left_corner + u * horizontal + v * vertical - origin, random_float(time0, time1));
+    }
+
+    // Returns the frustum of every ray get_ray() can make with u in [u0, u1] and v in [v0, v1]
+    frustum tile_frustum(float u0, float u1, float v0, float v1) const {
+        vec3 corner_dirs[4] = {
+            lower_left_corner + u0 * horizontal + v0 * vertical - origin,
+            lower_left_corner + u1 * horizontal + v0 * vertical - origin,
+            lower_left_corner + u1 * horizontal + v1 * vertical - origin,
+            lower_left_corner + u0 * horizontal + v1 * vertical - origin
+        };
+        return frustum(origin, corner_dirs);
+    }
+
+public:
+    vec3 origin;
+    vec3 lower_left_corner;
+    vec3 horizontal;
+    vec3 vertical;
+    float time0, time1;
+};
+
+#endif
\ No newline at end of file
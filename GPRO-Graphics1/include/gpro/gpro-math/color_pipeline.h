@@ -0,0 +1,144 @@
+/*
+    color_pipeline.h
+    Color pipeline stage; Turns the framebuffer's linear float color into 8-bit sRGB with exposure,
+    tonemapping and dithering
+
+    Written by: Michael Kashian (2020)
+*/
+
+#ifndef COLOR_PIPELINE_H
+#define COLOR_PIPELINE_H
+
+#include "gpro/gpro-math/framebuffer.h"
+#include "gpro/gpro-math/parallel.h"
+#include <math.h>
+
+// Curve used to bring HDR color into [0,1]
+enum tonemap_operator {
+    TONEMAP_CLAMP,      // Clips everything above 1
+    TONEMAP_REINHARD,   // x / (1 + x)
+    TONEMAP_ACES,       // Narkowicz (2015) fit of the ACES filmic curve
+};
+
+// Tuning for convert_to_srgb8()
+struct color_settings {
+    float exposure = 0.0f;                      // In stops; each stop doubles the brightness
+    tonemap_operator tonemap = TONEMAP_ACES;
+    bool dither = true;                         // Ordered dither of up to half a code value, hides banding
+};
+
+// Linear [0,1] to sRGB in code values [0,255], sampled at 4096 even steps of the linear value
+//	-> read with linear interpolation between neighbouring entries (max error about 0.005 of a code value);
+//	   the exact curve costs a pow per sample, and GCC keeps root-based fits of it scalar under default flags
+//	   (sqrtf has to set errno), so a small table is the fastest encode on every compiler
+struct srgb_table {
+    static const int size = 4096;
+    float code[size + 2];   // The extra entry lets a lookup at exactly 1.0 interpolate without a bounds check
+
+    srgb_table() {
+        for (int i = 0; i <= size + 1; i++) {
+            double x = i < size ? double(i) / size : 1.0;
+            double srgb = x <= 0.0031308 ? 12.92 * x : 1.055 * pow(x, 1.0 / 2.4) - 0.055;
+            code[i] = static_cast<float>(255.0 * srgb);
+        }
+    }
+};
+
+// The table is built once, on first use
+inline const srgb_table& get_srgb_table() {
+    static const srgb_table table;
+    return table;
+}
+
+// sRGB code value in [0,255] at pos in [0, srgb_table::size], the linear value times the table size
+inline float srgb_code_at(const float* code, float pos) {
+    int i = static_cast<int>(pos);
+    return code[i] + (pos - i) * (code[i + 1] - code[i]);
+}
+
+// Converts one row of the framebuffer into interleaved 8-bit RGB at out
+//	-> scratch must hold fb.width floats; each loop runs down one channel's contiguous plane
+//	-> every loop but the table lookups vectorizes
+inline void color_row(const framebuffer& fb, int row, const color_settings& settings, unsigned char* out, float* scratch) {
+    // 8x8 Bayer matrix; entry / 64 - 0.5 gives an offset in (-0.5, 0.5) of a code value
+    static const unsigned char bayer[8][8] = {
+        {  0, 32,  8, 40,  2, 34, 10, 42 },
+        { 48, 16, 56, 24, 50, 18, 58, 26 },
+        { 12, 44,  4, 36, 14, 46,  6, 38 },
+        { 60, 28, 52, 20, 62, 30, 54, 22 },
+        {  3, 35, 11, 43,  1, 33,  9, 41 },
+        { 51, 19, 59, 27, 49, 17, 57, 25 },
+        { 15, 47,  7, 39, 13, 45,  5, 37 },
+        { 63, 31, 55, 23, 61, 29, 53, 21 },
+    };
+    float dither[8];
+    for (int i = 0; i < 8; i++) {
+        dither[i] = settings.dither ? (bayer[row & 7][i] + 0.5f) / 64.0f : 0.5f;   // Includes the +0.5 for rounding
+    }
+
+    const int w = fb.width;
+    const float scale = powf(2.0f, settings.exposure);
+    const size_t p = size_t(row) * w;
+    const float* code = get_srgb_table().code;
+
+    for (int c = 0; c < 3; c++) {
+        const float* in = &fb.color[c][p];
+
+        // Exposure and tonemap
+        switch (settings.tonemap) {
+        case TONEMAP_REINHARD:
+            LOOP_IVDEP
+            for (int x = 0; x < w; x++) {
+                float v = in[x] * scale;
+                scratch[x] = v / (1.0f + v);
+            }
+            break;
+        case TONEMAP_ACES:
+            LOOP_IVDEP
+            for (int x = 0; x < w; x++) {
+                float v = in[x] * scale;
+                scratch[x] = (v * (2.51f * v + 0.03f)) / (v * (2.43f * v + 0.59f) + 0.14f);
+            }
+            break;
+        default:
+            LOOP_IVDEP
+            for (int x = 0; x < w; x++) {
+                scratch[x] = in[x] * scale;
+            }
+            break;
+        }
+
+        // Scale to a position in the sRGB table and clamp it there
+        //	-> the clamp comes last and the lookups get their own loop: GCC turns a select followed by more math
+        //	   back into a branch, which stops it from vectorizing the loop
+        LOOP_IVDEP
+        for (int x = 0; x < w; x++) {
+            float pos = scratch[x] * srgb_table::size;
+            pos = pos > 0.0f ? pos : 0.0f;
+            pos = pos < srgb_table::size ? pos : srgb_table::size;
+            scratch[x] = pos;
+        }
+
+        // sRGB encode, dither and quantize; the top code plus the largest dither stays below 256
+        for (int x = 0; x < w; x++) {
+            out[3 * x + c] = static_cast<unsigned char>(srgb_code_at(code, scratch[x]) + dither[x & 7]);
+        }
+    }
+}
+
+// Converts the framebuffer's color into 8-bit sRGB, 3 bytes per pixel from the top row down
+//	-> rows are split across the hardware threads
+inline void convert_to_srgb8(const framebuffer& fb, std::vector<unsigned char>& out, const color_settings& settings = color_settings()) {
+    out.resize(size_t(fb.width) * fb.height * 3);
+    if (out.empty()) {
+        return;
+    }
+
+    parallel_for(fb.height, [&](int row) {
+        thread_local std::vector<float> scratch;
+        scratch.resize(fb.width);
+        color_row(fb, row, settings, &out[size_t(row) * fb.width * 3], &scratch[0]);
+    });
+}
+
+#endif
\ No newline at end of file
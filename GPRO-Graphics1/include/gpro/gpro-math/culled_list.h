@@ -0,0 +1,42 @@
+/*
+    culled_list.h
+    Class creation for culled_list class; The objects of a world left after frustum culling, tested one by one
+
+    Written by: Michael Kashian (2020)
+*/
+
+#ifndef CULLED_LIST_H
+#define CULLED_LIST_H
+
+#include "gpro/gpro-math/hittable.h"
+#include <vector>
+
+// Holds plain pointers into a world that must outlive the list; meant to be refilled for each tile
+class culled_list : public hittable {
+public:
+    culled_list() {}    // Default constructor
+
+    // Replaces the contents with the objects of world that may be inside f during [time0, time1]
+    void collect(const hittable& world, const frustum& f, float time0, float time1) {
+        objects.clear();
+        world.cull(f, time0, time1, objects);
+    }
+
+    virtual bool hit_t(const ray_query& q, float tmin, float tmax, float& t, const hittable*& object) const override;   // Closest t where the ray hits any object
+    virtual bool bounding_box(float time0, float time1, aabb& output_box) const override;     // Box enclosing every object in the list
+
+public:
+    std::vector<const hittable*> objects;
+};
+
+// hit_t function implementation
+bool culled_list::hit_t(const ray_query& q, float t_min, float t_max, float& t, const hittable*& object) const {
+    return hit_t_all(objects, q, t_min, t_max, t, object);
+}
+
+// bounding_box function implementation
+bool culled_list::bounding_box(float time0, float time1, aabb& output_box) const {
+    return bounding_box_all(objects, time0, time1, output_box);
+}
+
+#endif
\ No newline at end of file
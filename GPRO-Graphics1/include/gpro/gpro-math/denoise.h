@@ -0,0 +1,164 @@
+/*
+    denoise.h
+    Edge-avoiding a-trous wavelet denoiser; Smooths the framebuffer's color while the normal, albedo and depth
+    AOVs keep it from blurring across edges
+
+    Based on: Dammertz et al. (2010) "Edge-Avoiding A-Trous Wavelet Transform for fast Global Illumination Filtering"
+    Written by: Michael Kashian (2020)
+*/
+
+#ifndef DENOISE_H
+#define DENOISE_H
+
+#include "gpro/gpro-math/framebuffer.h"
+#include "gpro/gpro-math/parallel.h"
+
+// Tuning for denoise(); a smaller sigma makes that channel stop the filter sooner
+struct denoise_settings {
+    int iterations = 3;         // Passes; pass i spreads the 5x5 kernel 2^i pixels apart
+    float sigma_color = 0.5f;   // Halved every pass, so later (wider) passes only remove what is left
+    float sigma_normal = 1.0f;  // The guides are as noisy as the color along edges at low sample counts,
+    float sigma_albedo = 1.0f;  // so they are kept loose enough to still average those pixels
+    float sigma_depth = 2.0f;   // Per pixel of distance, so sloped surfaces still blur
+};
+
+// Falls from 1 towards 0 as x grows from 0; stands in for exp(-x)
+//	-> only multiplies, adds and one divide, so the loops using it vectorize without a vector exp
+inline float edge_weight(float x) {
+    return 1.0f / (1.0f + x * (1.0f + x * (0.5f + x * (1.0f / 6.0f + x * (1.0f / 24.0f)))));
+}
+
+// One a-trous pass from src into dst over the rows [row, row + 1)
+//	-> for each of the 25 taps the whole row is processed at once, so the inner loop runs over
+//	   contiguous floats with no branches and the compiler can turn it into SIMD
+//	-> taps falling outside the image are left out rather than clamped; the weight sum accounts for it
+inline void denoise_row(const framebuffer& fb, const std::vector<float>* src, std::vector<float>* dst,
+    int row, int step, float inv_sigma_color2, const denoise_settings& settings, std::vector<float>& scratch) {
+    static const float kernel[5] = { 1.0f / 16.0f, 1.0f / 4.0f, 3.0f / 8.0f, 1.0f / 4.0f, 1.0f / 16.0f };
+
+    const int w = fb.width;
+    const float inv_sigma_normal2 = 1.0f / (settings.sigma_normal * settings.sigma_normal);
+    const float inv_sigma_albedo2 = 1.0f / (settings.sigma_albedo * settings.sigma_albedo);
+    const float inv_sigma_depth2 = 1.0f / (settings.sigma_depth * settings.sigma_depth * step * step);
+
+    scratch.assign(size_t(w) * 4, 0.0f);
+    float* sum_w = &scratch[0];
+    float* sum_r = sum_w + w;
+    float* sum_g = sum_r + w;
+    float* sum_b = sum_g + w;
+
+    const size_t p = size_t(row) * w;
+    for (int ky = 0; ky < 5; ky++) {
+        int qrow = row + (ky - 2) * step;
+        if (qrow < 0 || qrow >= fb.height) {
+            continue;
+        }
+        for (int kx = 0; kx < 5; kx++) {
+            int dx = (kx - 2) * step;
+            int x0 = dx < 0 ? -dx : 0;
+            int x1 = dx > 0 ? w - dx : w;
+            if (x1 <= x0) {
+                continue;
+            }
+            const int count = x1 - x0;
+            const float h = kernel[ky] * kernel[kx];
+
+            // Center pixels start at x0, their taps dx further along the neighbour row
+            const size_t pi = p + x0;
+            const size_t qi = size_t(qrow) * w + (x0 + dx);
+            const float* pr = &src[0][pi];
+            const float* pg = &src[1][pi];
+            const float* pb = &src[2][pi];
+            const float* pnx = &fb.normal[0][pi];
+            const float* pny = &fb.normal[1][pi];
+            const float* pnz = &fb.normal[2][pi];
+            const float* par = &fb.albedo[0][pi];
+            const float* pag = &fb.albedo[1][pi];
+            const float* pab = &fb.albedo[2][pi];
+            const float* pz = &fb.depth[pi];
+            const float* qr = &src[0][qi];
+            const float* qg = &src[1][qi];
+            const float* qb = &src[2][qi];
+            const float* qnx = &fb.normal[0][qi];
+            const float* qny = &fb.normal[1][qi];
+            const float* qnz = &fb.normal[2][qi];
+            const float* qar = &fb.albedo[0][qi];
+            const float* qag = &fb.albedo[1][qi];
+            const float* qab = &fb.albedo[2][qi];
+            const float* qz = &fb.depth[qi];
+            float* aw = sum_w + x0;
+            float* ar = sum_r + x0;
+            float* ag = sum_g + x0;
+            float* ab = sum_b + x0;
+
+            LOOP_IVDEP
+            for (int x = 0; x < count; x++) {
+                float dr = qr[x] - pr[x], dg = qg[x] - pg[x], db = qb[x] - pb[x];
+                float dnx = qnx[x] - pnx[x], dny = qny[x] - pny[x], dnz = qnz[x] - pnz[x];
+                float dar = qar[x] - par[x], dag = qag[x] - pag[x], dab = qab[x] - pab[x];
+                float dz = qz[x] - pz[x];
+
+                float cost = (dr * dr + dg * dg + db * db) * inv_sigma_color2
+                    + (dnx * dnx + dny * dny + dnz * dnz) * inv_sigma_normal2
+                    + (dar * dar + dag * dag + dab * dab) * inv_sigma_albedo2
+                    + dz * dz * inv_sigma_depth2;
+                float weight = h * edge_weight(cost);
+
+                aw[x] += weight;
+                ar[x] += weight * qr[x];
+                ag[x] += weight * qg[x];
+                ab[x] += weight * qb[x];
+            }
+        }
+    }
+
+    // The center tap always has weight, so the sum is never zero
+    float* out_r = &dst[0][p];
+    float* out_g = &dst[1][p];
+    float* out_b = &dst[2][p];
+    LOOP_IVDEP
+    for (int x = 0; x < w; x++) {
+        float inv_w = 1.0f / sum_w[x];
+        out_r[x] = sum_r[x] * inv_w;
+        out_g[x] = sum_g[x] * inv_w;
+        out_b[x] = sum_b[x] * inv_w;
+    }
+}
+
+// Denoises fb.color in place, guided by the normal, albedo and depth AOVs
+//	-> each pass is split by rows across the hardware threads
+inline void denoise(framebuffer& fb, const denoise_settings& settings = denoise_settings()) {
+    if (fb.width == 0 || fb.height == 0) {
+        return;
+    }
+
+    std::vector<float> temp[3];
+    for (int c = 0; c < 3; c++) {
+        temp[c].resize(fb.color[c].size());
+    }
+
+    std::vector<float>* src = fb.color;
+    std::vector<float>* dst = temp;
+    float sigma_color = settings.sigma_color;
+    for (int i = 0; i < settings.iterations; i++) {
+        int step = 1 << i;
+        float inv_sigma_color2 = 1.0f / (sigma_color * sigma_color);
+        parallel_for(fb.height, [&](int row) {
+            thread_local std::vector<float> scratch;
+            denoise_row(fb, src, dst, row, step, inv_sigma_color2, settings, scratch);
+        });
+        std::vector<float>* swap = src;
+        src = dst;
+        dst = swap;
+        sigma_color *= 0.5f;
+    }
+
+    // After an odd number of passes the result sits in temp
+    if (src != fb.color) {
+        for (int c = 0; c < 3; c++) {
+            fb.color[c].swap(temp[c]);
+        }
+    }
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,62 @@
+/*
+    framebuffer.h
+    Class creation for framebuffer class and struct aov_sample; Float image holding the rendered color and the
+    arbitrary output variables (AOVs) a post-process such as the denoiser can use
+
+    Written by: Michael Kashian (2020)
+*/
+
+#ifndef FRAMEBUFFER_H
+#define FRAMEBUFFER_H
+
+#include "gpro/gpro-math/gproVector.h"
+#include <vector>
+
+// The AOVs of one sample, taken from the first surface the ray hits
+//	-> normal: hit_record.normal, zero where the ray escapes
+//	-> albedo: base color of the surface, or the sky color where the ray escapes
+//	-> depth: hit_record.t, zero where the ray escapes
+struct aov_sample {
+    vec3 normal;
+    vec3 albedo;
+    float depth;
+};
+
+// Every channel is its own plane (structure of arrays) so filters can run down a row of one channel
+// with contiguous loads; pixels are stored row by row starting from the top of the image
+class framebuffer {
+public:
+    framebuffer() : width(0), height(0) {}  // Default constructor
+    framebuffer(int w, int h) : width(w), height(h), depth(size_t(w) * h) {    // Constructor with image size
+        for (int c = 0; c < 3; c++) {
+            color[c].resize(depth.size());
+            normal[c].resize(depth.size());
+            albedo[c].resize(depth.size());
+        }
+    }
+
+    // Index of pixel i along a row, j rows up from the bottom (the renderer's convention)
+    size_t index(int i, int j) const { return size_t(height - 1 - j) * width + i; }
+
+    // Stores a pixel's color and AOVs
+    void set_pixel(size_t idx, const vec3& pixel_color, const aov_sample& aov) {
+        for (int c = 0; c < 3; c++) {
+            color[c][idx] = pixel_color.v[c];
+            normal[c][idx] = aov.normal.v[c];
+            albedo[c][idx] = aov.albedo.v[c];
+        }
+        depth[idx] = aov.depth;
+    }
+
+    // Returns a pixel's color
+    vec3 color_at(size_t idx) const { return vec3(color[0][idx], color[1][idx], color[2][idx]); }
+
+public:
+    int width, height;
+    std::vector<float> color[3];
+    std::vector<float> normal[3];
+    std::vector<float> albedo[3];
+    std::vector<float> depth;
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,48 @@
+/*
+    frustum.h
+    Class creation for frustum class; The pyramid of space one tile of the image can see, for culling objects per tile
+
+    Written by: Michael Kashian (2020)
+*/
+
+#ifndef FRUSTUM_H
+#define FRUSTUM_H
+
+#include "gpro/gpro-math/aabb.h"
+
+// Four side planes through the camera origin, each with its normal pointing into the pyramid
+//	-> no near or far plane: opposite side planes already shut out everything behind the origin
+class frustum {
+public:
+    frustum() {}    // Default constructor
+
+    // Constructor with the camera origin and the directions through the tile's corners, in order around the tile
+    frustum(const vec3& origin, const vec3 corner_dirs[4]) : apex(origin) {
+        vec3 center_dir = corner_dirs[0] + corner_dirs[1] + corner_dirs[2] + corner_dirs[3];
+        for (int i = 0; i < 4; i++) {
+            vec3 n = cross(corner_dirs[i], corner_dirs[(i + 1) % 4]);
+            normal[i] = dot(n, center_dir) < 0.0f ? -1.0f * n : n;
+        }
+    }
+
+    // Determines if any part of the box may be inside the frustum (conservative)
+    //	-> the box is outside as soon as its corner farthest along some plane's normal is behind that plane
+    bool overlaps(const aabb& box) const {
+        for (int i = 0; i < 4; i++) {
+            const vec3& n = normal[i];
+            vec3 far_corner(n.x >= 0.0f ? box.maximum.x : box.minimum.x,
+                n.y >= 0.0f ? box.maximum.y : box.minimum.y,
+                n.z >= 0.0f ? box.maximum.z : box.minimum.z);
+            if (dot(n, far_corner - apex) < 0.0f) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+public:
+    vec3 apex;
+    vec3 normal[4];
+};
+
+#endif
\ No newline at end of file
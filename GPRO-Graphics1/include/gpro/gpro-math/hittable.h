@@ -10,6 +10,9 @@
 #define HITTABLE_H
 
 #include "gpro/gpro-math/ray.h"
+#include "gpro/gpro-math/aabb.h"
+#include "gpro/gpro-math/frustum.h"
+#include <vector>
 
 // Original Code: Peter Shirley (2020) "Ray Tracing in One Weekend"
 // Modified by: Michael Kashian
@@ -30,9 +33,79 @@ struct hit_record {
 
 // Original Code: Peter Shirley (2020) "Ray Tracing in One Weekend"
 // Modified by: Michael Kashian
+//	-> hit() is the full query; it is built from the two fast-path calls below:
+//		hit_t() searches for the closest hit using t alone and reports which object it was on,
+//		then only that object runs fill_hit() to work out the point, normal, etc.
 class hittable {
 public:
-    virtual bool hit(const ray& r, float t_min, float t_max, hit_record& rec) const = 0;    // Determines if the ray hits the object
+    virtual bool hit(const ray& r, float t_min, float t_max, hit_record& rec) const;    // Determines if the ray hits the object, filling rec for the closest hit
+    virtual bool hit_t(const ray_query& q, float t_min, float t_max, float& t, const hittable*& object) const = 0; // Closest t in (t_min, t_max) and the object hit there
+    virtual void fill_hit(const ray& r, float t, hit_record& rec) const;  // Fills rec for a hit found by hit_t() on this object
+    virtual bool bounding_box(float time0, float time1, aabb& output_box) const = 0;     // Box enclosing the object over the whole shutter interval [time0, time1]
+    virtual void cull(const frustum& f, float time0, float time1, std::vector<const hittable*>& candidates) const;  // Adds the objects that may be inside the frustum to candidates
 };
 
+// hit function implementation
+bool hittable::hit(const ray& r, float t_min, float t_max, hit_record& rec) const {
+    ray_query q(r);
+    float t;
+    const hittable* object;
+    if (!hit_t(q, t_min, t_max, t, object)) {
+        return false;
+    }
+    object->fill_hit(r, t, rec);
+    return true;
+}
+
+// fill_hit function implementation
+// Fills what every surface has; surfaces override it to add their normal
+void hittable::fill_hit(const ray& r, float t, hit_record& rec) const {
+    rec.t = t;
+    rec.p = r.at(t);
+}
+
+
+// cull function implementation
+// Keeps the object unless its box is entirely outside the frustum; objects without a box are always kept
+void hittable::cull(const frustum& f, float time0, float time1, std::vector<const hittable*>& candidates) const {
+    aabb box;
+    if (!bounding_box(time0, time1, box) || f.overlaps(box)) {
+        candidates.push_back(this);
+    }
+}
+
+// Shared by the list types, which differ only in how they hold their objects (shared_ptr or plain pointer)
+//	-> objects is any vector of pointer-likes to hittables
+
+// Closest t over every object, narrowing the range to the closest hit so far; only t and the object are kept
+template<typename Objects>
+bool hit_t_all(const Objects& objects, const ray_query& q, float t_min, float t_max, float& t, const hittable*& object) {
+    bool hit_anything = false;
+    float closest_so_far = t_max;
+
+    for (size_t i = 0; i < objects.size(); i++) {
+        if (objects[i]->hit_t(q, t_min, closest_so_far, closest_so_far, object)) {
+            hit_anything = true;
+        }
+    }
+    t = closest_so_far;
+    return hit_anything;
+}
+
+// Box enclosing every object; there is none if the range is empty or any object is unbounded
+template<typename Objects>
+bool bounding_box_all(const Objects& objects, float time0, float time1, aabb& output_box) {
+    if (objects.empty()) {
+        return false;
+    }
+
+    aabb temp_box;
+    for (size_t i = 0; i < objects.size(); i++) {
+        if (!objects[i]->bounding_box(time0, time1, temp_box)) {
+            return false;
+        }
+        output_box = i == 0 ? temp_box : surrounding_box(output_box, temp_box);
+    }
+    return true;
+}
 #endif
\ No newline at end of file
@@ -27,29 +27,33 @@ public:
     void clear() { objects.clear(); }   // Clears the objects vector
     void add(shared_ptr<hittable> object) { objects.push_back(object); }    // Adds an object to the objects vector
 
-    virtual bool hit(const ray& r, float tmin, float tmax, hit_record& rec) const override;     // Determines if the ray hits the object
+    virtual bool hit_t(const ray_query& q, float tmin, float tmax, float& t, const hittable*& object) const override;   // Closest t where the ray hits any object
+    virtual bool bounding_box(float time0, float time1, aabb& output_box) const override;     // Box enclosing every object in the list
+    virtual void cull(const frustum& f, float time0, float time1, std::vector<const hittable*>& candidates) const override;   // Culls each object in the list
 
 public:
     std::vector<shared_ptr<hittable>> objects;  // The objects vector
 };
 
-// hit function implementation
+// hit_t function implementation
 // Original Code: Peter Shirley (2020) "Ray Tracing in One Weekend"
 // Modified by: Michael Kashian
-bool hittable_list::hit(const ray& r, float t_min, float t_max, hit_record& rec) const {
-    hit_record temp_rec;
-    bool hit_anything = false;
-    float closest_so_far = t_max;
-
-    // Loops through each object and, given the ray, determines if it hits and object and what object it is
-    for (int i = 0; i < objects.size(); i++) {
-        const shared_ptr<hittable>& object = objects[i];
-        if (object->hit(r, t_min, closest_so_far, temp_rec)) {
-            hit_anything = true;
-            closest_so_far = temp_rec.t;
-            rec = temp_rec;
-        }
+bool hittable_list::hit_t(const ray_query& q, float t_min, float t_max, float& t, const hittable*& object) const {
+    return hit_t_all(objects, q, t_min, t_max, t, object);
+}
+
+// bounding_box function implementation
+// Original Code: Peter Shirley (2020) "Ray Tracing: The Next Week"
+// Modified by: Michael Kashian
+bool hittable_list::bounding_box(float time0, float time1, aabb& output_box) const {
+    return bounding_box_all(objects, time0, time1, output_box);
+}
+
+// cull function implementation
+// Hands the frustum to each object, so nested lists and bvhs add their own objects rather than themselves
+void hittable_list::cull(const frustum& f, float time0, float time1, std::vector<const hittable*>& candidates) const {
+    for (size_t i = 0; i < objects.size(); i++) {
+        objects[i]->cull(f, time0, time1, candidates);
     }
-    return hit_anything;
 }
 #endif
\ No newline at end of file
@@ -0,0 +1,79 @@
+/*
+    moving_sphere.h
+    Class creation for moving_sphere class; Sphere whose center moves linearly over the shutter interval, giving motion blur
+
+    Original code: Peter Shirley (2020) "Ray Tracing: The Next Week" (Version 3.2.0) [Source Code]. https://raytracing.github.io/books/RayTracingTheNextWeek.html#motionblur
+    Modified by: Michael Kashian (2020)
+*/
+
+#ifndef MOVING_SPHERE_H
+#define MOVING_SPHERE_H
+
+#include "gpro/gpro-math/hittable.h"
+#include "gpro/gpro-math/sphere.h"
+#include "gpro/gpro-math/gproVector.h"
+
+// Original Code: Peter Shirley (2020) "Ray Tracing: The Next Week"
+// Modified by: Michael Kashian
+class moving_sphere : public hittable {
+public:
+    moving_sphere() {}  // Default constructor
+    moving_sphere(vec3 cen0, vec3 cen1, float _time0, float _time1, float r)
+        : center0(cen0), center1(cen1), time0(_time0), time1(_time1), radius(r),
+          inv_duration(_time1 > _time0 ? 1.0f / (_time1 - _time0) : 0.0f) {};  // Constructor with the start/end centers, their times and the radius; a zero-length interval keeps the sphere at cen0
+
+    virtual bool hit_t(const ray_query& q, float tmin, float tmax, float& t, const hittable*& object) const override;   // Closest t where the ray hits the sphere at the ray's time
+    virtual void fill_hit(const ray& r, float t, hit_record& rec) const override;   // Fills rec, including the normal, for a hit at t
+    virtual bool bounding_box(float _time0, float _time1, aabb& output_box) const override;   // Box enclosing the sphere over [_time0, _time1]
+
+    vec3 center(float time) const;  // Returns the center at the given time
+
+public:
+    vec3 center0, center1;
+    float time0, time1;
+    float radius;
+    float inv_duration;     // 1 / (time1 - time0), or 0 when the interval is empty, so center() needs no division
+};
+
+// center function implementation
+// Multiplies by the inverse interval length stored at construction instead of dividing on every hit
+// Original Code: Peter Shirley (2020) "Ray Tracing: The Next Week"
+// Modified by: Michael Kashian
+vec3 moving_sphere::center(float time) const {
+    return center0 + ((time - time0) * inv_duration) * (center1 - center0);
+}
+
+// hit_t function implementation
+// Same test as sphere, against the center at the ray's time
+// Original Code: Peter Shirley (2020) "Ray Tracing: The Next Week"
+// Modified by: Michael Kashian
+bool moving_sphere::hit_t(const ray_query& q, float t_min, float t_max, float& t, const hittable*& object) const {
+    if (!hit_sphere_t(q, center(q.r.time()), radius, t_min, t_max, t)) {
+        return false;
+    }
+    object = this;
+    return true;
+}
+
+// fill_hit function implementation
+// Original Code: Peter Shirley (2020) "Ray Tracing: The Next Week"
+// Modified by: Michael Kashian
+void moving_sphere::fill_hit(const ray& r, float t, hit_record& rec) const {
+    hittable::fill_hit(r, t, rec);
+    vec3 outward_normal = (rec.p - center(r.time())) / radius;
+    rec.set_face_normal(r, outward_normal);
+}
+
+// bounding_box function implementation
+// The box is expanded to cover the sphere at both ends of the interval, so a bvh built
+// from it stays valid for every ray time instead of falling back to testing the sphere always
+// Original Code: Peter Shirley (2020) "Ray Tracing: The Next Week"
+// Modified by: Michael Kashian
+bool moving_sphere::bounding_box(float _time0, float _time1, aabb& output_box) const {
+    vec3 rad(radius, radius, radius);
+    aabb box0(center(_time0) - rad, center(_time0) + rad);
+    aabb box1(center(_time1) - rad, center(_time1) + rad);
+    output_box = surrounding_box(box0, box1);
+    return true;
+}
+#endif
\ No newline at end of file
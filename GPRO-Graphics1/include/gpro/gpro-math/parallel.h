@@ -0,0 +1,56 @@
+/*
+    parallel.h
+    Definition of parallel_for; Spreads independent pieces of work (rows, tiles) across the hardware threads
+
+    Written by: Michael Kashian (2020)
+*/
+
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+// Placed right before a loop to tell the compiler that the arrays it reads and writes never overlap,
+// which it cannot prove by itself through plain pointers, so that it vectorizes the loop
+#if defined(_MSC_VER)
+#define LOOP_IVDEP __pragma(loop(ivdep))
+#elif defined(__GNUC__)
+#define LOOP_IVDEP _Pragma("GCC ivdep")
+#else
+#define LOOP_IVDEP
+#endif
+
+// Calls body(i) once for every i in [0, count), using every hardware thread
+//	-> threads pull the next index from a shared counter, so uneven pieces of work still balance
+//	-> body must be safe to call from several threads at once
+template <typename F>
+void parallel_for(int count, const F& body) {
+    int thread_count = static_cast<int>(std::thread::hardware_concurrency());
+    if (thread_count < 1) {
+        thread_count = 1;
+    }
+    if (thread_count > count) {
+        thread_count = count;
+    }
+
+    std::atomic<int> next(0);
+    auto worker = [&]() {
+        for (int i = next++; i < count; i = next++) {
+            body(i);
+        }
+    };
+
+    // The calling thread works too instead of only waiting
+    std::vector<std::thread> threads;
+    for (int t = 1; t < thread_count; t++) {
+        threads.emplace_back(worker);
+    }
+    worker();
+    for (size_t t = 0; t < threads.size(); t++) {
+        threads[t].join();
+    }
+}
+
+#endif
\ No newline at end of file
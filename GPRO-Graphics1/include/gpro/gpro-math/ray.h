@@ -1,6 +1,6 @@
 /*
     ray.h
-    Class creation for ray class; Container for vec3s and at() function
+    Class creation for ray class; Container for vec3s, the ray's time and at() function; struct ray_query with its precomputed terms
 
     Original code: Peter Shirley (2020) "Ray Tracing in One Weekend" (Version 3.2.0) [Source Code]. https://raytracing.github.io/books/RayTracingInOneWeekend.html#thevec3class/variablesandmethods
     Modified by: Michael Kashian (2020)
@@ -16,10 +16,11 @@
 class ray {
 public:
     ray() {}    // Default constructor
-    ray(const vec3& origin, const vec3& direction) : orig(origin), dir(direction){} // Constructor with two vec3 parameters
+    ray(const vec3& origin, const vec3& direction, float time = 0.0f) : orig(origin), dir(direction), tm(time) {} // Constructor with two vec3 parameters and an optional time
 
     vec3 origin() const { return orig; }    // Returns orig
     vec3 direction() const { return dir; }  // Returns dir
+    float time() const { return tm; }       // Returns tm, the moment within the shutter interval the ray samples
 
     // Calculates point on the vector at a given t
     // Original Code: Peter Shirley (2020) "Ray Tracing in One Weekend"
@@ -31,6 +32,21 @@ public:
 public:
     vec3 orig;
     vec3 dir;
+    float tm;
+};
+
+// A ray together with the terms every intersection test against it shares
+//	-> built once per ray, so objects don't each recompute them (or divide by them)
+struct ray_query {
+    // Constructor with the ray being traced
+    explicit ray_query(const ray& _r)
+        : r(_r), a(dot(_r.dir, _r.dir)), inv_a(1.0f / a),
+        inv_dir(1.0f / _r.dir.x, 1.0f / _r.dir.y, 1.0f / _r.dir.z) {}
+
+    ray r;          // The ray itself
+    float a;        // Squared length of the direction; the quadratic 'a' of every sphere test
+    float inv_a;    // 1 / a
+    vec3 inv_dir;   // Per-axis 1 / direction, for the box slab test
 };
 
 #endif // !RAY_H
\ No newline at end of file
@@ -13,6 +13,7 @@
 #include <cstdlib>
 #include <limits>
 #include <memory>
+#include <random>
 
 
 // Usings
@@ -32,6 +33,28 @@ inline double degrees_to_radians(double degrees) {
     return degrees * pi / 180.0;
 }
 
+// Returns the calling thread's random number generator
+//	-> one per thread so threads never share state; reseed it per piece of work to get the same image every run
+inline std::mt19937& random_generator() {
+    thread_local std::mt19937 generator;
+    return generator;
+}
+
+// Returns a random float in [0,1)
+// Original Code: Peter Shirley (2020) "Ray Tracing in One Weekend"
+// Modified by: Michael Kashian
+inline float random_float() {
+    std::uniform_real_distribution<float> distribution(0.0f, 1.0f);
+    return distribution(random_generator());
+}
+
+// Returns a random float in [min,max)
+// Original Code: Peter Shirley (2020) "Ray Tracing in One Weekend"
+// Modified by: Michael Kashian
+inline float random_float(float min, float max) {
+    return min + (max - min) * random_float();
+}
+
 // Common Headers
 
 #include "gpro/gpro-math/ray.h"
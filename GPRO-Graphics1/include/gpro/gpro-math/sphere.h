@@ -12,6 +12,37 @@
 #include "gpro/gpro-math/hittable.h"
 #include "gpro/gpro-math/gproVector.h"
 
+// Finds the closest t in (t_min, t_max) where the ray meets the sphere; shared by sphere and moving_sphere
+//	-> the query already holds a = |direction|^2 and its inverse, so there is no division here
+//	-> a near root past t_max (behind the closest hit so far) rejects at once; the far root is only
+//	   tried when the near one is before t_min (the origin is inside the sphere)
+// Original Code: Peter Shirley (2020) "Ray Tracing in One Weekend"
+// Modified by: Michael Kashian
+inline bool hit_sphere_t(const ray_query& q, const vec3& center, float radius, float t_min, float t_max, float& t) {
+    vec3 oc = q.r.orig - center;
+    float half_b = dot(oc, q.r.dir);
+    float c = dot(oc, oc) - radius * radius;
+
+    float discriminant = half_b * half_b - q.a * c;
+    if (discriminant <= 0.0f) {
+        return false;
+    }
+
+    float root = sqrt(discriminant);
+    float temp = (-half_b - root) * q.inv_a;
+    if (temp >= t_max) {
+        return false;
+    }
+    if (temp <= t_min) {
+        temp = (-half_b + root) * q.inv_a;
+        if (temp <= t_min || temp >= t_max) {
+            return false;
+        }
+    }
+    t = temp;
+    return true;
+}
+
 // Original Code: Peter Shirley (2020) "Ray Tracing in One Weekend"
 // Modified by: Michael Kashian
 class sphere : public hittable {
@@ -19,46 +50,40 @@ public:
     sphere() {} // Default constructor
     sphere(vec3 cen, float r) : center(cen), radius(r) {};  // Constructor with vec3 and float parameters
 
-    virtual bool hit(const ray& r, float tmin, float tmax, hit_record& rec) const override;     // Determines if the ray hits the object
+    virtual bool hit_t(const ray_query& q, float tmin, float tmax, float& t, const hittable*& object) const override;   // Closest t where the ray hits the sphere
+    virtual void fill_hit(const ray& r, float t, hit_record& rec) const override;   // Fills rec, including the normal, for a hit at t
+    virtual bool bounding_box(float time0, float time1, aabb& output_box) const override;     // Box enclosing the sphere
 
 public:
     vec3 center;
     float radius;
 };
 
-// hit function implementation
+// hit_t function implementation
 // Original Code: Peter Shirley (2020) "Ray Tracing in One Weekend"
 // Modified by: Michael Kashian
-bool sphere::hit(const ray& r, float t_min, float t_max, hit_record& rec) const {
-    vec3 oc = r.origin() - center;
-    float a = r.direction().length_squared(r.direction());
-    float half_b = dot(oc, r.direction());
-    float c = oc.length_squared(oc) - radius * radius;
-    float discriminant = half_b * half_b - a * c;
-
-    // Determines how the ray intersects with the object using an outwards normal
-    if (discriminant > 0) {
-        float root = sqrt(discriminant);
+bool sphere::hit_t(const ray_query& q, float t_min, float t_max, float& t, const hittable*& object) const {
+    if (!hit_sphere_t(q, center, radius, t_min, t_max, t)) {
+        return false;
+    }
+    object = this;
+    return true;
+}
 
-        // If the ray is in the sphere, return true and update rec
-        float temp = (-half_b - root) / a;
-        if (temp < t_max && temp > t_min) {
-            rec.t = temp;
-            rec.p = r.at(rec.t);
-            vec3 outward_normal = (rec.p - center) / radius;
-            rec.set_face_normal(r, outward_normal);
-            return true;
-        }
+// fill_hit function implementation
+// Original Code: Peter Shirley (2020) "Ray Tracing in One Weekend"
+// Modified by: Michael Kashian
+void sphere::fill_hit(const ray& r, float t, hit_record& rec) const {
+    hittable::fill_hit(r, t, rec);
+    vec3 outward_normal = (rec.p - center) / radius;
+    rec.set_face_normal(r, outward_normal);
+}
 
-        temp = (-half_b + root) / a;
-        if (temp < t_max && temp > t_min) {
-            rec.t = temp;
-            rec.p = r.at(rec.t);
-            vec3 outward_normal = (rec.p - center) / radius;
-            rec.set_face_normal(r, outward_normal);
-            return true;
-        }
-    }
-    return false;
+// bounding_box function implementation
+// Original Code: Peter Shirley (2020) "Ray Tracing: The Next Week"
+// Modified by: Michael Kashian
+bool sphere::bounding_box(float time0, float time1, aabb& output_box) const {
+    output_box = aabb(center - vec3(radius, radius, radius), center + vec3(radius, radius, radius));
+    return true;
 }
 #endif
\ No newline at end of file
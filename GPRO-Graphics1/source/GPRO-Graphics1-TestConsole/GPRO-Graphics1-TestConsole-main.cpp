@@ -35,6 +35,13 @@
 #include "gpro/gpro-math/rtweekend.h"
 #include "gpro/gpro-math/hittable_list.h"
 #include "gpro/gpro-math/sphere.h"
+#include "gpro/gpro-math/moving_sphere.h"
+#include "gpro/gpro-math/bvh.h"
+#include "gpro/gpro-math/camera.h"
+#include "gpro/gpro-math/framebuffer.h"
+#include "gpro/gpro-math/denoise.h"
+#include "gpro/gpro-math/culled_list.h"
+#include "gpro/gpro-math/color_pipeline.h"
 
 void testVector()
 {
@@ -66,18 +73,19 @@ void testVector()
 // For opening and writing to a file in C++
 #include <string>
 #include <fstream>
+#include <chrono>
 #else //!__cplusplus
 // For opening and writing to a file in C
 #include <stdio.h>
 #endif //__cplusplus
 
-// Writes out each pixel color to the given outstream
+// Writes out a pixel's 8-bit color, already converted by the color pipeline, to the given outstream
 // Original Code: Peter Shirley (2020) "Ray Tracing in One Weekend"
 // Modified by: Michael Kashian
-void write_color(std::ostream& out, vec3 pixel_color) {
-	out << static_cast<int>(255.999 * pixel_color.x) << ' '
-		<< static_cast<int>(255.999 * pixel_color.y) << ' '
-		<< static_cast<int>(255.999 * pixel_color.z) << '\n';
+void write_color(std::ostream& out, const unsigned char* rgb) {
+	out << int(rgb[0]) << ' '
+		<< int(rgb[1]) << ' '
+		<< int(rgb[2]) << '\n';
 }
 
 // Determines if and how many times a ray intersects with a sphere
@@ -98,23 +106,335 @@ float hit_sphere(const vec3& center, float radius, const ray& r) {
 	}
 }
 
-// Determines the color of the pixel given the ray's intersectors
+// Determines the color of the pixel given the ray's intersectors, and fills in the AOVs of the first hit
 // Original Code: Peter Shirley (2020) "Ray Tracing in One Weekend"
 // Modified by: Michael Kashian
-vec3 ray_color(const ray& r, const hittable& world) {
+vec3 ray_color(const ray& r, const hittable& world, aov_sample& aov) {
 	hit_record rec;
 	if (world.hit(r, 0, infinity, rec)) {
-		return 0.5f * (rec.normal + vec3(1.0f, 1.0f, 1.0f));
+		// Surfaces are colored by their normal and unlit, so the albedo is the color itself
+		vec3 albedo = 0.5f * (rec.normal + vec3(1.0f, 1.0f, 1.0f));
+		aov.normal = rec.normal;
+		aov.albedo = albedo;
+		aov.depth = rec.t;
+		return albedo;
 	}
 	vec3 unit_direction = unit_vector(r.direction());
 	float t = 0.5f * (unit_direction.y + 1.0f);
-	return (1.0f - t) * vec3(1.0f, 1.0f, 1.0f) + t * vec3(0.5f, 0.7f, 1.0f);
+	vec3 sky = (1.0f - t) * vec3(1.0f, 1.0f, 1.0f) + t * vec3(0.5f, 0.7f, 1.0f);
+	aov.normal = vec3(0.0f, 0.0f, 0.0f);
+	aov.albedo = sky;
+	aov.depth = 0.0f;
+	return sky;
 }
 
+#ifdef __cplusplus
+// Renders the world into the framebuffer, storing each pixel's color and AOVs averaged over its samples
+//	-> the image is split into tiles that are rendered in parallel
+//	-> with cull_tiles, each tile first culls the world against its frustum into a short candidate list,
+//	   and its primary rays test only those (every ray ray_color casts is a primary ray)
+// Original Code: Peter Shirley (2020) "Ray Tracing in One Weekend"
+// Modified by: Michael Kashian
+void render(framebuffer& fb, const hittable& world, const camera& cam, int samples_per_pixel, bool cull_tiles = true)
+{
+	const int tile_size = 16;
+	const int tiles_x = (fb.width + tile_size - 1) / tile_size;
+	const int tiles_y = (fb.height + tile_size - 1) / tile_size;
+	const float scale = 1.0f / samples_per_pixel;
+
+	std::cerr << "Rendering " << tiles_x * tiles_y << " tiles\n";
+	parallel_for(tiles_x * tiles_y, [&](int tile)
+	{
+		const int i0 = (tile % tiles_x) * tile_size;
+		const int j0 = (tile / tiles_x) * tile_size;
+		const int i1 = i0 + tile_size < fb.width ? i0 + tile_size : fb.width;
+		const int j1 = j0 + tile_size < fb.height ? j0 + tile_size : fb.height;
+
+		// Each tile has its own random sequence, so the image doesn't depend on which thread rendered it
+		random_generator().seed(tile + 1);
+
+		// Jittered samples of pixels [i0, i1) reach u = i1 / (width - 1) at most, and likewise for v
+		thread_local culled_list candidates;
+		if (cull_tiles) {
+			frustum f = cam.tile_frustum(float(i0) / (fb.width - 1), float(i1) / (fb.width - 1),
+				float(j0) / (fb.height - 1), float(j1) / (fb.height - 1));
+			candidates.collect(world, f, cam.time0, cam.time1);
+		}
+		const hittable& tile_world = cull_tiles ? static_cast<const hittable&>(candidates) : world;
+
+		for (int j = j0; j < j1; j++)
+		{
+			for (int i = i0; i < i1; i++)
+			{
+				vec3 pixel_color(0.0f, 0.0f, 0.0f);
+				aov_sample pixel_aov = { vec3(0.0f, 0.0f, 0.0f), vec3(0.0f, 0.0f, 0.0f), 0.0f };
+				for (int s = 0; s < samples_per_pixel; s++)
+				{
+					float u = (i + random_float()) / (fb.width - 1);
+					float v = (j + random_float()) / (fb.height - 1);
+					aov_sample aov;
+					pixel_color += ray_color(cam.get_ray(u, v), tile_world, aov);
+					pixel_aov.normal += aov.normal;
+					pixel_aov.albedo += aov.albedo;
+					pixel_aov.depth += aov.depth;
+				}
+				pixel_aov.normal *= scale;
+				pixel_aov.albedo *= scale;
+				pixel_aov.depth *= scale;
+				fb.set_pixel(fb.index(i, j), scale * pixel_color, pixel_aov);
+			}
+		}
+	});
+}
+#endif	// __cplusplus
+
+#ifdef __cplusplus
+// Times the same primary rays against a static and a moving version of a scene of many small spheres
+//	-> prints the cost per ray of each, and of the moving scene without the bvh for comparison
+void testMotionBlurCost()
+{
+	const int sphere_count = 1000;
+	const int ray_count = 400 * 225;
+	const float time0 = 0.0f, time1 = 1.0f;
+
+	// Same centers in both scenes; the moving spheres travel up to half a unit during the shutter
+	hittable_list static_world, moving_world;
+	for (int i = 0; i < sphere_count; i++) {
+		vec3 center(random_float(-4.0f, 4.0f), random_float(-2.0f, 2.0f), random_float(-8.0f, -2.0f));
+		vec3 velocity(0.0f, random_float(0.0f, 0.5f), 0.0f);
+		static_world.add(make_shared<sphere>(center, 0.05f));
+		moving_world.add(make_shared<moving_sphere>(center, center + velocity, time0, time1, 0.05f));
+	}
+	bvh_node static_bvh(static_world, time0, time1);
+	bvh_node moving_bvh(moving_world, time0, time1);
+
+	std::vector<ray> rays;
+	for (int i = 0; i < ray_count; i++) {
+		vec3 dir(random_float(-2.0f, 2.0f), random_float(-1.0f, 1.0f), -1.0f);
+		rays.push_back(ray(vec3(0.0f, 0.0f, 0.0f), dir, random_float(time0, time1)));
+	}
+
+	const hittable* worlds[] = { &static_bvh, &moving_bvh, &moving_world };
+	const char* names[] = { "static bvh", "moving bvh", "moving list" };
+	for (int w = 0; w < 3; w++) {
+		hit_record rec;
+		int hits = 0;
+		auto start = std::chrono::steady_clock::now();
+		for (size_t i = 0; i < rays.size(); i++) {
+			hits += worlds[w]->hit(rays[i], 0.0f, float(infinity), rec) ? 1 : 0;
+		}
+		std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+		printf("%-12s %8.1f ns/ray (%d hits)\n", names[w], elapsed.count() / rays.size(), hits);
+	}
+}
+#endif	// __cplusplus
+
+#ifdef __cplusplus
+// Microbenchmark of world.hit() as the number of spheres grows
+//	-> the same rays are cast at a flat list and at a bvh of each scene size
+//	-> prints the best of five runs in ns per ray, and how many spheres an average ray passes through
+void testHitScaling()
+{
+	const int ray_count = 20000;
+	const int scene_sizes[] = { 16, 64, 256, 1024, 4096 };
+
+	std::vector<ray> rays;
+	for (int i = 0; i < ray_count; i++) {
+		vec3 dir(random_float(-2.0f, 2.0f), random_float(-1.0f, 1.0f), -1.0f);
+		rays.push_back(ray(vec3(0.0f, 0.0f, 0.0f), dir));
+	}
+
+	for (int n = 0; n < 5; n++) {
+		hittable_list list;
+		for (int i = 0; i < scene_sizes[n]; i++) {
+			vec3 center(random_float(-4.0f, 4.0f), random_float(-2.0f, 2.0f), random_float(-8.0f, -2.0f));
+			list.add(make_shared<sphere>(center, 0.3f));
+		}
+		bvh_node tree(list, 0.0f, 0.0f);
+
+		// Spheres crossed per ray, counted one at a time
+		int crossings = 0;
+		for (size_t i = 0; i < rays.size(); i++) {
+			hit_record rec;
+			for (size_t o = 0; o < list.objects.size(); o++) {
+				crossings += list.objects[o]->hit(rays[i], 0.0f, float(infinity), rec) ? 1 : 0;
+			}
+		}
+
+		const hittable* worlds[] = { &list, &tree };
+		double ns_per_ray[2] = { 0.0, 0.0 };
+		for (int w = 0; w < 2; w++) {
+			for (int run = 0; run < 5; run++) {
+				hit_record rec;
+				auto start = std::chrono::steady_clock::now();
+				for (size_t i = 0; i < rays.size(); i++) {
+					worlds[w]->hit(rays[i], 0.0f, float(infinity), rec);
+				}
+				std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+				double ns = elapsed.count() / rays.size();
+				ns_per_ray[w] = (run == 0 || ns < ns_per_ray[w]) ? ns : ns_per_ray[w];
+			}
+		}
+		printf("%5d spheres (%5.2f crossed/ray): list %9.1f ns/ray, bvh %7.1f ns/ray\n",
+			scene_sizes[n], float(crossings) / rays.size(), ns_per_ray[0], ns_per_ray[1]);
+	}
+}
+
+// Renders a particle scene with and without tile culling as particles outside the view are added
+//	-> the 2000 visible particles stay the same; only the hidden ones grow
+//	-> prints the render time of each and the average candidates per tile
+void testTileCulling()
+{
+	const int image_width = 400;
+	const int image_height = 225;
+	const int visible_count = 2000;
+	const int hidden_counts[] = { 0, 20000, 200000 };
+	camera cam(16.0f / 9.0f, 2.0f, 1.0f);
+
+	for (int n = 0; n < 3; n++) {
+		random_generator().seed(1);
+		hittable_list particles;
+		for (int i = 0; i < visible_count; i++) {
+			float depth = random_float(2.0f, 8.0f);
+			vec3 center = depth * unit_vector(cam.get_ray(random_float(), random_float()).direction());
+			particles.add(make_shared<sphere>(center, 0.02f));
+		}
+		for (int i = 0; i < hidden_counts[n]; i++) {
+			float side = random_float() < 0.5f ? -1.0f : 1.0f;
+			vec3 center(side * random_float(16.0f, 40.0f), random_float(-8.0f, 8.0f), random_float(-8.0f, -2.0f));
+			particles.add(make_shared<sphere>(center, 0.02f));
+		}
+		bvh_node world(particles, 0.0f, 0.0f);
+
+		// Average candidate list length over all 16x16 tiles
+		const int tiles_x = (image_width + 15) / 16, tiles_y = (image_height + 15) / 16;
+		size_t candidate_total = 0;
+		culled_list candidates;
+		for (int tile = 0; tile < tiles_x * tiles_y; tile++) {
+			int i0 = (tile % tiles_x) * 16, j0 = (tile / tiles_x) * 16;
+			int i1 = i0 + 16 < image_width ? i0 + 16 : image_width, j1 = j0 + 16 < image_height ? j0 + 16 : image_height;
+			candidates.collect(world, cam.tile_frustum(float(i0) / (image_width - 1), float(i1) / (image_width - 1),
+				float(j0) / (image_height - 1), float(j1) / (image_height - 1)), 0.0f, 0.0f);
+			candidate_total += candidates.objects.size();
+		}
+
+		double ms[2];
+		for (int cull = 0; cull < 2; cull++) {
+			framebuffer fb(image_width, image_height);
+			auto start = std::chrono::steady_clock::now();
+			render(fb, world, cam, 4, cull == 1);
+			std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+			ms[cull] = elapsed.count();
+		}
+		printf("%6d objects: bvh only %7.1f ms, tile culled %7.1f ms (%.1f candidates/tile)\n",
+			visible_count + hidden_counts[n], ms[0], ms[1], double(candidate_total) / (tiles_x * tiles_y));
+	}
+}
+
+// Times the color pipeline on a 4K frame of HDR values
+//	-> prints the best of five conversions for each tonemap, and the worst sRGB encoding error in code values
+void testColorPipeline()
+{
+	const int image_width = 3840;
+	const int image_height = 2160;
+
+	// Values from 0 up to 16 across the frame, so every part of the tonemap curves is used
+	framebuffer fb(image_width, image_height);
+	for (int c = 0; c < 3; c++) {
+		for (size_t i = 0; i < fb.color[c].size(); i++) {
+			float t = float(i % image_width) / (image_width - 1);
+			fb.color[c][i] = 16.0f * t * t * (c + 1) / 3.0f;
+		}
+	}
+
+	const float* code = get_srgb_table().code;
+	float worst = 0.0f;
+	for (int i = 0; i <= 100000; i++) {
+		float x = i / 100000.0f;
+		float exact = x <= 0.0031308f ? 12.92f * x : 1.055f * powf(x, 1.0f / 2.4f) - 0.055f;
+		float error = fabsf(srgb_code_at(code, x * srgb_table::size) - exact * 255.0f);
+		worst = error > worst ? error : worst;
+	}
+	printf("sRGB encoding: worst error %.4f code values\n", worst);
+
+	const tonemap_operator operators[] = { TONEMAP_CLAMP, TONEMAP_REINHARD, TONEMAP_ACES };
+	const char* names[] = { "clamp", "reinhard", "aces" };
+	std::vector<unsigned char> image;
+	for (int o = 0; o < 3; o++) {
+		color_settings settings;
+		settings.tonemap = operators[o];
+		double best = 0.0;
+		for (int run = 0; run < 5; run++) {
+			auto start = std::chrono::steady_clock::now();
+			convert_to_srgb8(fb, image, settings);
+			std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+			best = (run == 0 || elapsed.count() < best) ? elapsed.count() : best;
+		}
+		printf("%-8s %dx%d in %.2f ms\n", names[o], image_width, image_height, best);
+	}
+}
+
+// Root mean square difference between the colors of two framebuffers of the same size
+float color_rmse(const framebuffer& a, const framebuffer& b)
+{
+	double sum = 0.0;
+	for (int c = 0; c < 3; c++) {
+		for (size_t i = 0; i < a.color[c].size(); i++) {
+			double d = a.color[c][i] - b.color[c][i];
+			sum += d * d;
+		}
+	}
+	return float(sqrt(sum / (3.0 * a.color[0].size())));
+}
+
+// Compares denoised low-sample renders against plain renders of a blurred scene
+//	-> error of each is measured against a 1024 sample reference
+//	-> prints the denoise time and how many plain samples it takes to match the denoised error
+void testDenoise()
+{
+	const int image_width = 400;
+	const int image_height = 225;
+	const float time0 = 0.0f, time1 = 1.0f;
+
+	hittable_list objects;
+	objects.add(make_shared<sphere>(vec3(0.0f, 0.0f, -1.0f), 0.5f));
+	objects.add(make_shared<sphere>(vec3(0.0f, -100.5f, -1.0f), 100.0f));
+	objects.add(make_shared<moving_sphere>(vec3(-1.2f, 0.0f, -1.5f), vec3(-1.2f, 0.4f, -1.5f), time0, time1, 0.3f));
+	objects.add(make_shared<moving_sphere>(vec3(1.0f, -0.2f, -1.2f), vec3(1.4f, -0.2f, -1.2f), time0, time1, 0.25f));
+	bvh_node world(objects, time0, time1);
+	camera cam(16.0f / 9.0f, 2.0f, 1.0f, time0, time1);
+
+	framebuffer reference(image_width, image_height);
+	render(reference, world, cam, 1024);
+
+	const int low_samples[] = { 1, 2, 4, 8 };
+	for (int i = 0; i < 4; i++) {
+		framebuffer fb(image_width, image_height);
+		render(fb, world, cam, low_samples[i]);
+		float noisy = color_rmse(fb, reference);
+		auto start = std::chrono::steady_clock::now();
+		denoise(fb);
+		std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+		printf("%4d spp: rmse %.4f, denoised %.4f in %.2f ms\n", low_samples[i], noisy, color_rmse(fb, reference), elapsed.count());
+	}
+	const int high_samples[] = { 16, 32, 64, 128, 256 };
+	for (int i = 0; i < 5; i++) {
+		framebuffer fb(image_width, image_height);
+		render(fb, world, cam, high_samples[i]);
+		printf("%4d spp: rmse %.4f\n", high_samples[i], color_rmse(fb, reference));
+	}
+}
+#endif	// __cplusplus
+
 // main function
 int main(int const argc, char const* const argv[])
 {
 	//testVector();
+	//testMotionBlurCost();
+	//testDenoise();
+	//testHitScaling();
+	//testTileCulling();
+	//testColorPipeline();
 
 	#ifdef __cplusplus
 
@@ -124,42 +444,43 @@ int main(int const argc, char const* const argv[])
 	const float aspect_ratio = 16.0f / 9.0f;
 	const int image_width = 400;
 	const int image_height = static_cast<int>(image_width / aspect_ratio);
+	const int samples_per_pixel = 16;
+	const bool denoise_image = true;
+
+	// Shutter interval; each sample's ray gets a random time in it so moving objects blur
+	const float time0 = 0.0f;
+	const float time1 = 1.0f;
 
 	//World
-	hittable_list world;
+	hittable_list objects;
 	// Adding the objects to the scene
-	world.add(make_shared<sphere>(vec3(0.0f, 0.0f, -1.0f), 0.5f));
-	world.add(make_shared<sphere>(vec3(0.0f, -100.5f, -1.0f), 100.0f));
+	objects.add(make_shared<sphere>(vec3(0.0f, 0.0f, -1.0f), 0.5f));
+	objects.add(make_shared<sphere>(vec3(0.0f, -100.5f, -1.0f), 100.0f));
+	// Boxes of moving objects cover the whole shutter interval
+	bvh_node world(objects, time0, time1);
 
 	// Camera
 	float viewport_height = 2.0f;
-	float viewport_width = aspect_ratio * viewport_height;
 	float focal_length = 1.0f;
-
-	vec3 origin = vec3(0.0f, 0.0f, 0.0f);
-	vec3 horizontal = vec3(viewport_width, 0.0f, 0.0f);
-	vec3 vertical = vec3(0.0f, viewport_height, 0.0f);
-	vec3 lower_left_corner = origin - horizontal / 2 - vertical / 2 - vec3(0.0f, 0.0f, focal_length);
+	camera cam(aspect_ratio, viewport_height, focal_length, time0, time1);
 
 	// Render
-	// Opens the output file and writes the header
+	framebuffer fb(image_width, image_height);
+	render(fb, world, cam, samples_per_pixel);
+	if (denoise_image) {
+		denoise(fb);
+	}
+
+	// Exposure, tonemap and sRGB encoding of the whole image at once
+	std::vector<unsigned char> image;
+	convert_to_srgb8(fb, image);
+
+	// Opens the output file, writes the header and then every pixel from the top row down
 	std::ofstream outfile("image.ppm");
 	outfile << "P3\n" << image_width << " " << image_height << "\n255\n";
-
-	// Loops through evey pixel in the image, determiens their color, and writes them to the file
-	// Original Code: Peter Shirley (2020) "Ray Tracing in One Weekend"
-	// Modified by: Michael Kashian
-	for (int j = image_height - 1; j >= 0; j--)
+	for (size_t i = 0; i < image.size(); i += 3)
 	{
-		std::cerr << "\rScanlines remaining: " << j << ' ' << std::flush;
-		for (int i = 0; i < image_width; i++)
-		{
-			float u = float(i) / (image_width - 1);
-			float v = float(j) / (image_height - 1);
-			ray r(origin, lower_left_corner + u * horizontal + v * vertical);
-			vec3 pixel_color = ray_color(r, world);
-			write_color(outfile, pixel_color);
-		}
+		write_color(outfile, &image[i]);
 	}
 	// Closes file
 	outfile.close();